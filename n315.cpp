@@ -1,7 +1,37 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 #include <cassert> // Include for assert
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 // All code in the global namespace as requested
 
@@ -13,6 +43,9 @@ struct DataProcessingPipeline;
 template <typename Record>
 struct EndOfProcessing;
 
+template <typename Record, typename... Actions>
+struct BatchProcessingPipeline;
+
 // Represents a data record in the 1950s business context
 template <typename NameType, typename DepartmentType, typename SalaryType, typename HireDateType>
 struct EmployeeRecord {
@@ -33,78 +66,717 @@ std::ostream& operator<<(std::ostream& os,
     return os;
 }
 
+// Applies one action with its positional stage argument: a std::tuple is unpacked into the
+// action's arguments (std::tuple{} for actions that take none), anything else is passed as is
+template <typename T>
+inline constexpr bool is_stage_tuple = false;
+
+template <typename... Ts>
+inline constexpr bool is_stage_tuple<std::tuple<Ts...>> = true;
+
+template <typename Action, typename Record, typename StageArg>
+auto apply_stage(Record&& record, StageArg&& stage_arg) {
+    if constexpr (is_stage_tuple<std::remove_cvref_t<StageArg>>) {
+        return std::apply([&record](auto&&... args) {
+            return Action::template apply<Record>(std::move(record), std::forward<decltype(args)>(args)...);
+        }, std::forward<StageArg>(stage_arg));
+    } else {
+        return Action::template apply<Record>(std::move(record), std::forward<StageArg>(stage_arg));
+    }
+}
+
+// Folds every action into one call chain at compile time; no intermediate pipeline objects
+template <typename Record, typename Action, typename... RemainingActions, typename StageArg, typename... RemainingArgs>
+auto run_stages(Record record, StageArg&& stage_arg, RemainingArgs&&... remaining_args) {
+    auto next_record = apply_stage<Action>(std::move(record), std::forward<StageArg>(stage_arg));
+    if constexpr (sizeof...(RemainingActions) == 0) {
+        return next_record;
+    } else {
+        return run_stages<decltype(next_record), RemainingActions...>(std::move(next_record), std::forward<RemainingArgs>(remaining_args)...);
+    }
+}
+
 // Base case for the processing pipeline
 template <typename Record>
 struct DataProcessingPipeline<Record> {
     using CurrentRecord = Record;
 
-    DataProcessingPipeline(Record initial_record) : current_record(initial_record) {}
+    explicit DataProcessingPipeline(CurrentRecord record) : current_record(std::move(record)) {}
 
-    CurrentRecord get_final_record() const { return current_record; }
+    CurrentRecord get_final_record() const& { return current_record; }
+    CurrentRecord get_final_record() && { return std::move(current_record); }
 
 private:
     CurrentRecord current_record;
 };
 
-// Recursive structure for the processing pipeline
+// Recursive structure for the processing pipeline. The record is moved from stage to stage;
+// processing an lvalue pipeline copies it first so that pipeline stays usable.
 template <typename Record, typename Action, typename... RemainingActions>
 struct DataProcessingPipeline<Record, Action, RemainingActions...> {
     using CurrentRecord = Record;
     using CurrentAction = Action;
-    using RemainingPipeline = DataProcessingPipeline<CurrentRecord, RemainingActions...>;
 
-    CurrentRecord initial_record;
+    explicit DataProcessingPipeline(CurrentRecord record) : current_record(std::move(record)) {}
 
-    DataProcessingPipeline(CurrentRecord initial_record) : initial_record(initial_record) {}
+    // Runs every remaining action in one fused call, one stage argument per action by position
+    template <typename... StageArgs>
+    static auto run(CurrentRecord record, StageArgs&&... stage_args) {
+        static_assert(sizeof...(StageArgs) == 1 + sizeof...(RemainingActions),
+                      "run takes exactly one stage argument per action");
+        return run_stages<CurrentRecord, CurrentAction, RemainingActions...>(std::move(record), std::forward<StageArgs>(stage_args)...);
+    }
 
     template <typename... Args>
-    auto process(Args&&... args) {
-        // Apply the current action to the current record
-        auto next_record = CurrentAction::template apply<CurrentRecord>(initial_record, std::forward<Args>(args)...);
-        return DataProcessingPipeline<decltype(next_record), RemainingActions...>(next_record);
+    auto process(Args&&... args) const& {
+        return advance(CurrentRecord(current_record), std::forward<Args>(args)...);
     }
 
-    auto process() {
-        auto next_record = CurrentAction::template apply<CurrentRecord>(initial_record);
-        return DataProcessingPipeline<decltype(next_record), RemainingActions...>(next_record);
+    template <typename... Args>
+    auto process(Args&&... args) && {
+        return advance(std::move(current_record), std::forward<Args>(args)...);
     }
 
-    decltype(auto) get_final_record() const {
-        // This should only be called on the final stage of the pipeline
-        static_assert(std::is_same_v<DataProcessingPipeline<Record, Action, RemainingActions...>, DataProcessingPipeline<Record>>,
-                      "get_final_record should only be called on the completed pipeline");
-        return initial_record;
+private:
+    template <typename... Args>
+    static auto advance(CurrentRecord&& record, Args&&... args) {
+        // Apply the current action to the current record
+        auto next_record = CurrentAction::template apply<CurrentRecord>(std::move(record), std::forward<Args>(args)...);
+        return DataProcessingPipeline<decltype(next_record), RemainingActions...>(std::move(next_record));
     }
 
-private:
-    CurrentRecord current_record = initial_record;
+    CurrentRecord current_record;
 };
 
 // Helper function to start the pipeline
 template <typename Record, typename Action, typename... RemainingActions>
 auto start_processing(Record initial_record) {
-    return DataProcessingPipeline<Record, Action, RemainingActions...>(initial_record);
+    return DataProcessingPipeline<Record, Action, RemainingActions...>(std::move(initial_record));
+}
+
+// Pushes a whole batch through one action. Actions may provide
+// `apply_batch<Record>(std::vector<Record>, args...)`, a plain loop the compiler can vectorize;
+// otherwise the per-record `apply` runs over every element, in place when the record type
+// does not change.
+template <typename Action, typename Record, typename... Args>
+auto apply_to_batch(std::vector<Record> records, const Args&... args) {
+    if constexpr (requires { Action::template apply_batch<Record>(std::move(records), args...); }) {
+        return Action::template apply_batch<Record>(std::move(records), args...);
+    } else {
+        using NextRecord = decltype(Action::template apply<Record>(std::declval<Record>(), args...));
+        if constexpr (std::is_same_v<NextRecord, Record>) {
+            for (auto& record : records) {
+                record = Action::template apply<Record>(std::move(record), args...);
+            }
+            return records;
+        } else {
+            std::vector<NextRecord> next_records;
+            next_records.reserve(records.size());
+            for (auto& record : records) {
+                next_records.push_back(Action::template apply<Record>(std::move(record), args...));
+            }
+            return next_records;
+        }
+    }
+}
+
+// Positional stage argument for a batch: a std::tuple is unpacked as in apply_stage
+template <typename Action, typename Record, typename StageArg>
+auto apply_batch_stage(std::vector<Record> records, const StageArg& stage_arg) {
+    if constexpr (is_stage_tuple<StageArg>) {
+        return std::apply([&records](const auto&... args) { return apply_to_batch<Action>(std::move(records), args...); }, stage_arg);
+    } else {
+        return apply_to_batch<Action>(std::move(records), stage_arg);
+    }
+}
+
+template <typename Record, typename Action, typename... RemainingActions, typename StageArg, typename... RemainingArgs>
+auto run_batch_stages(std::vector<Record> records, const StageArg& stage_arg, const RemainingArgs&... remaining_args) {
+    auto next_records = apply_batch_stage<Action>(std::move(records), stage_arg);
+    if constexpr (sizeof...(RemainingActions) == 0) {
+        return next_records;
+    } else {
+        return run_batch_stages<typename decltype(next_records)::value_type, RemainingActions...>(std::move(next_records), remaining_args...);
+    }
+}
+
+// Batch counterpart of DataProcessingPipeline: each process() call runs one action over
+// every record, so dispatch happens once per stage instead of once per record
+template <typename Record>
+struct BatchProcessingPipeline<Record> {
+    explicit BatchProcessingPipeline(std::vector<Record> records) : records(std::move(records)) {}
+
+    const std::vector<Record>& get_final_records() const& { return records; }
+    std::vector<Record> get_final_records() && { return std::move(records); }
+
+private:
+    std::vector<Record> records;
+};
+
+template <typename Record, typename Action, typename... RemainingActions>
+struct BatchProcessingPipeline<Record, Action, RemainingActions...> {
+    explicit BatchProcessingPipeline(std::vector<Record> records) : records(std::move(records)) {}
+
+    // Batch form of DataProcessingPipeline::run: every action over the whole batch in one call
+    template <typename... StageArgs>
+    static auto run(std::vector<Record> records, const StageArgs&... stage_args) {
+        static_assert(sizeof...(StageArgs) == 1 + sizeof...(RemainingActions),
+                      "run takes exactly one stage argument per action");
+        return run_batch_stages<Record, Action, RemainingActions...>(std::move(records), stage_args...);
+    }
+
+    template <typename... Args>
+    auto process(Args&&... args) {
+        auto next_records = apply_to_batch<Action>(std::move(records), args...);
+        return BatchProcessingPipeline<typename decltype(next_records)::value_type, RemainingActions...>(std::move(next_records));
+    }
+
+private:
+    std::vector<Record> records;
+};
+
+template <typename Record, typename Action, typename... RemainingActions>
+auto start_batch_processing(std::vector<Record> records) {
+    return BatchProcessingPipeline<Record, Action, RemainingActions...>(std::move(records));
+}
+
+template <typename Record, typename Action, typename... RemainingActions>
+auto start_batch_processing(std::span<const Record> records) {
+    return BatchProcessingPipeline<Record, Action, RemainingActions...>(std::vector<Record>(records.begin(), records.end()));
 }
 
+// ---------------------- Pipelined Execution ----------------------
+
+// Bounded lock-free queue between exactly one producer and one consumer thread. Each side
+// caches the other's index and only reloads it when the queue looks full or empty. The
+// blocking push()/pop() spin briefly and then park on a condition variable; the lock is only
+// taken when a side is actually parked.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity) : slots(std::bit_ceil(std::max<std::size_t>(capacity, 2))), mask(slots.size() - 1) {}
+
+    // Moves from `value` only when there was room
+    bool try_push(T& value) {
+        const std::size_t position = tail.load(std::memory_order_relaxed);
+        if (position - cached_head == slots.size()) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (position - cached_head == slots.size()) {
+                return false;
+            }
+        }
+        slots[position & mask].emplace(std::move(value));
+        tail.store(position + 1, std::memory_order_release);
+        wake();
+        return true;
+    }
+
+    std::optional<T> try_pop() {
+        const std::size_t position = head.load(std::memory_order_relaxed);
+        if (position == cached_tail) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (position == cached_tail) {
+                return std::nullopt;
+            }
+        }
+        auto& slot = slots[position & mask];
+        std::optional<T> value(std::move(slot));
+        slot.reset();
+        head.store(position + 1, std::memory_order_release);
+        wake();
+        return value;
+    }
+
+    // Waits for room; false when the queue was cancelled instead
+    bool push(T& value) {
+        while (!try_push(value)) {
+            wait_until([this] { return cancelled() || size() < slots.size(); });
+            if (cancelled()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Waits for a value; nullopt once the queue is closed and drained, or cancelled
+    std::optional<T> pop() {
+        while (!cancelled()) {
+            // Read before popping: empty after the producer closed means fully drained
+            const bool was_closed = closed();
+            if (auto value = try_pop()) {
+                return value;
+            }
+            if (was_closed) {
+                return std::nullopt;
+            }
+            wait_until([this] { return cancelled() || closed() || size() > 0; });
+        }
+        return std::nullopt;
+    }
+
+    // Producer side: no further pushes will follow
+    void close() {
+        closed_flag.store(true, std::memory_order_release);
+        wake();
+    }
+    bool closed() const { return closed_flag.load(std::memory_order_acquire); }
+
+    // Either side: stop waiting and give up on the remaining values
+    void cancel() {
+        cancelled_flag.store(true, std::memory_order_release);
+        wake();
+    }
+    bool cancelled() const { return cancelled_flag.load(std::memory_order_acquire); }
+
+    // Safe from any thread: head is read first so a concurrent pop cannot make it pass tail,
+    // and pushes landing between the two loads are clamped to the capacity
+    std::size_t size() const {
+        const std::size_t consumed = head.load(std::memory_order_acquire);
+        const std::size_t produced = tail.load(std::memory_order_acquire);
+        return produced > consumed ? std::min(produced - consumed, slots.size()) : 0;
+    }
+    std::size_t capacity() const { return slots.size(); }
+
+private:
+    static constexpr int spin_limit = 64;
+
+    template <typename Ready>
+    void wait_until(Ready ready) {
+        for (int spin = 0; spin < spin_limit; ++spin) {
+            if (ready()) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+        std::unique_lock lock(park_mutex);
+        // Both sides read-modify-write `sleepers`, which orders them: either the waker sees
+        // this sleeper, or this sleeper's ready() check sees the waker's update
+        sleepers.fetch_add(1, std::memory_order_acq_rel);
+        parked.wait(lock, ready);
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void wake() {
+        if (sleepers.fetch_add(0, std::memory_order_acq_rel) > 0) {
+            std::lock_guard lock(park_mutex);
+            parked.notify_all();
+        }
+    }
+
+    std::vector<std::optional<T>> slots;
+    const std::size_t mask;
+    alignas(64) std::atomic<std::size_t> head{0};
+    std::size_t cached_tail = 0;
+    alignas(64) std::atomic<std::size_t> tail{0};
+    std::size_t cached_head = 0;
+    alignas(64) std::atomic<bool> closed_flag{false};
+    std::atomic<bool> cancelled_flag{false};
+    std::atomic<int> sleepers{0};
+    std::mutex park_mutex;
+    std::condition_variable parked;
+};
+
+template <typename... Actions>
+struct action_list {};
+
+// Record type entering each stage, plus the final one: std::tuple<Record, Next1, ..., Final>
+template <typename Record, typename ActionList, typename StageArgList>
+struct stage_records;
+
+template <typename Record>
+struct stage_records<Record, action_list<>, std::tuple<>> {
+    using type = std::tuple<Record>;
+};
+
+template <typename Record, typename Action, typename... RemainingActions, typename StageArg, typename... RemainingArgs>
+struct stage_records<Record, action_list<Action, RemainingActions...>, std::tuple<StageArg, RemainingArgs...>> {
+    using NextRecord = decltype(apply_stage<Action>(std::declval<Record>(), std::declval<const StageArg&>()));
+    using type = decltype(std::tuple_cat(std::declval<std::tuple<Record>>(),
+                                         std::declval<typename stage_records<NextRecord, action_list<RemainingActions...>, std::tuple<RemainingArgs...>>::type>()));
+};
+
+template <typename Record, typename ActionList, typename... StageArgs>
+class PipelinedExecutor;
+
+// Runs every action on its own worker thread; neighbouring stages hand records over through
+// bounded SpscRings, so a slow stage backs up the ones before it instead of growing memory,
+// and idle stages park rather than spin. push() feeds records, pop() collects results in
+// input order, run() does both for a batch. An executor handles one stream: once close() (or
+// run()) has ended the input, further push()/run() calls throw std::logic_error. An exception
+// thrown by an action stops the pipeline and is rethrown from push(), pop() or run().
+template <typename Record, typename... Actions, typename... StageArgs>
+class PipelinedExecutor<Record, action_list<Actions...>, StageArgs...> {
+    static constexpr std::size_t stage_count = sizeof...(Actions);
+    using Records = typename stage_records<Record, action_list<Actions...>, std::tuple<StageArgs...>>::type;
+
+    template <typename Tuple>
+    struct queues_for;
+
+    template <typename... StageRecords>
+    struct queues_for<std::tuple<StageRecords...>> {
+        using type = std::tuple<SpscRing<StageRecords>...>;
+    };
+
+public:
+    using ResultRecord = std::tuple_element_t<stage_count, Records>;
+
+    struct StageStats {
+        std::uint64_t processed;      // records the stage has handed downstream
+        std::size_t queue_depth;      // records currently waiting in the stage's input queue
+        std::size_t peak_queue_depth;
+        std::uint64_t output_stalls;  // waits on a full downstream queue (backpressure)
+        double records_per_second;    // since the executor started
+    };
+
+    template <typename... Args>
+    explicit PipelinedExecutor(std::size_t queue_capacity, Args&&... args)
+        : stage_args(std::forward<Args>(args)...),
+          queues(make_queues(queue_capacity, std::make_index_sequence<stage_count + 1>{})),
+          started(std::chrono::steady_clock::now()) {
+        start_workers(std::make_index_sequence<stage_count>{});
+    }
+
+    PipelinedExecutor(const PipelinedExecutor&) = delete;
+    PipelinedExecutor& operator=(const PipelinedExecutor&) = delete;
+
+    // Abandons records still in flight; drain with pop() first to keep them
+    ~PipelinedExecutor() {
+        cancel_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // Blocks while the first stage's queue is full
+    void push(Record record) {
+        auto& input = std::get<0>(queues);
+        if (input.closed()) {
+            throw std::logic_error("PipelinedExecutor: push after close");
+        }
+        if (!input.push(record)) {
+            rethrow_failure();
+        }
+    }
+
+    // No further input; pop() returns nullopt once every pushed record has come out
+    void close() { std::get<0>(queues).close(); }
+
+    std::optional<ResultRecord> try_pop() { return std::get<stage_count>(queues).try_pop(); }
+
+    std::optional<ResultRecord> pop() {
+        auto record = std::get<stage_count>(queues).pop();
+        if (!record) {
+            rethrow_failure();
+        }
+        return record;
+    }
+
+    // Feeds a whole batch from a helper thread while this one collects the results
+    std::vector<ResultRecord> run(std::span<const Record> records) {
+        if (std::get<0>(queues).closed()) {
+            throw std::logic_error("PipelinedExecutor: run after close");
+        }
+        std::thread feeder([this, records] {
+            auto& input = std::get<0>(queues);
+            for (const auto& source : records) {
+                Record record = source;
+                if (!input.push(record)) {
+                    return;
+                }
+            }
+            input.close();
+        });
+
+        std::vector<ResultRecord> results;
+        results.reserve(records.size());
+        try {
+            while (auto result = pop()) {
+                results.push_back(std::move(*result));
+            }
+        } catch (...) {
+            feeder.join();
+            throw;
+        }
+        feeder.join();
+        return results;
+    }
+
+    StageStats stage_stats(std::size_t stage) const {
+        const auto& counters = stage_counters[stage];
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        const std::uint64_t processed = counters.processed.load(std::memory_order_relaxed);
+        return StageStats{processed, queue_depths()[stage], counters.peak_queue_depth.load(std::memory_order_relaxed),
+                          counters.output_stalls.load(std::memory_order_relaxed), seconds > 0 ? processed / seconds : 0.0};
+    }
+
+    static constexpr std::size_t stages() { return stage_count; }
+
+private:
+    struct alignas(64) StageCounters {
+        std::atomic<std::uint64_t> processed{0};
+        std::atomic<std::size_t> peak_queue_depth{0};
+        std::atomic<std::uint64_t> output_stalls{0};
+    };
+
+    template <std::size_t... Queues>
+    static auto make_queues(std::size_t capacity, std::index_sequence<Queues...>) {
+        return typename queues_for<Records>::type(((void)Queues, capacity)...);
+    }
+
+    template <std::size_t... Stages>
+    void start_workers(std::index_sequence<Stages...>) {
+        workers = {std::thread(&PipelinedExecutor::template run_stage<Stages>, this)...};
+    }
+
+    template <std::size_t Stage>
+    void run_stage() {
+        using Action = std::tuple_element_t<Stage, std::tuple<Actions...>>;
+        auto& input = std::get<Stage>(queues);
+        auto& output = std::get<Stage + 1>(queues);
+        auto& counters = stage_counters[Stage];
+        const auto& stage_arg = std::get<Stage>(stage_args);
+
+        while (true) {
+            const std::size_t depth = input.size();
+            auto record = input.pop();
+            if (!record) {
+                break;
+            }
+            if (depth > counters.peak_queue_depth.load(std::memory_order_relaxed)) {
+                counters.peak_queue_depth.store(depth, std::memory_order_relaxed);
+            }
+
+            std::optional<std::tuple_element_t<Stage + 1, Records>> next_record;
+            try {
+                next_record.emplace(apply_stage<Action>(std::move(*record), stage_arg));
+            } catch (...) {
+                fail(std::current_exception());
+                return;
+            }
+            if (!output.try_push(*next_record)) {
+                counters.output_stalls.fetch_add(1, std::memory_order_relaxed);
+                if (!output.push(*next_record)) {
+                    return;
+                }
+            }
+            counters.processed.fetch_add(1, std::memory_order_relaxed);
+        }
+        output.close();
+    }
+
+    // Keeps the first error and stops every stage, waking anything parked on a queue
+    void fail(std::exception_ptr error) {
+        {
+            std::lock_guard lock(failure_mutex);
+            if (!failure) {
+                failure = error;
+            }
+        }
+        cancel_all();
+    }
+
+    void rethrow_failure() {
+        std::lock_guard lock(failure_mutex);
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    void cancel_all() {
+        std::apply([](auto&... queue) { (queue.cancel(), ...); }, queues);
+    }
+
+    std::array<std::size_t, stage_count + 1> queue_depths() const {
+        return std::apply([](const auto&... queue) { return std::array<std::size_t, stage_count + 1>{queue.size()...}; }, queues);
+    }
+
+    const std::tuple<StageArgs...> stage_args;
+    typename queues_for<Records>::type queues;
+    std::array<StageCounters, stage_count> stage_counters;
+    std::mutex failure_mutex;
+    std::exception_ptr failure;
+    const std::chrono::steady_clock::time_point started;
+    std::array<std::thread, stage_count> workers;
+};
+
+// Helper function to start a pipelined run; takes one stage argument per action, as run() does
+template <typename Record, typename... Actions, typename... StageArgs>
+auto start_pipelined_processing(std::size_t queue_capacity, StageArgs&&... stage_args) {
+    static_assert(sizeof...(StageArgs) == sizeof...(Actions), "start_pipelined_processing takes exactly one stage argument per action");
+    return PipelinedExecutor<Record, action_list<Actions...>, std::decay_t<StageArgs>...>(queue_capacity, std::forward<StageArgs>(stage_args)...);
+}
+
+// ---------------------- Columnar Storage ----------------------
+
+// The four EmployeeRecord fields, in template parameter order
+enum class EmployeeField { name, department, salary, hire_date };
+
+// Columns an action touches; actions declare `using reads = field_list<...>` and
+// `using writes = field_list<...>` to run over an EmployeeTable
+template <EmployeeField... Fields>
+struct field_list {
+    static constexpr bool contains(EmployeeField field) { return ((field == Fields) || ...); }
+};
+
+// Columns handed to an action's apply_columns: written columns come back as std::span<T>,
+// read-only ones as std::span<const T>, and touching an undeclared column fails to compile
+template <typename Table, typename Reads, typename Writes>
+class ColumnView {
+public:
+    explicit ColumnView(Table& table) : table(table) {}
+
+    template <EmployeeField Field>
+    auto column() const {
+        static_assert(Reads::contains(Field) || Writes::contains(Field), "action uses a column it did not declare");
+        auto& values = table.template column<Field>();
+        if constexpr (Writes::contains(Field)) {
+            return std::span<typename Table::template column_type<Field>>(values);
+        } else {
+            return std::span<const typename Table::template column_type<Field>>(values);
+        }
+    }
+
+    std::size_t size() const { return table.size(); }
+
+private:
+    Table& table;
+};
+
+// Structure-of-arrays counterpart of EmployeeRecord: every field lives in its own column, so
+// an action that only declares the salary column streams a single contiguous array
+template <typename NameType, typename DepartmentType, typename SalaryType, typename HireDateType>
+class EmployeeTable {
+public:
+    using Record = EmployeeRecord<NameType, DepartmentType, SalaryType, HireDateType>;
+
+    template <EmployeeField Field>
+    using column_type = std::tuple_element_t<static_cast<std::size_t>(Field), std::tuple<NameType, DepartmentType, SalaryType, HireDateType>>;
+
+    EmployeeTable() = default;
+
+    explicit EmployeeTable(std::span<const Record> records) {
+        reserve(records.size());
+        for (const auto& record : records) {
+            push_back(record);
+        }
+    }
+
+    void reserve(std::size_t count) {
+        std::apply([count](auto&... column) { (column.reserve(count), ...); }, columns);
+    }
+
+    void push_back(Record record) {
+        column<EmployeeField::name>().push_back(std::move(record.name));
+        column<EmployeeField::department>().push_back(std::move(record.department));
+        column<EmployeeField::salary>().push_back(std::move(record.salary));
+        column<EmployeeField::hire_date>().push_back(std::move(record.hire_date));
+    }
+
+    std::size_t size() const { return std::get<0>(columns).size(); }
+
+    Record row(std::size_t index) const {
+        return Record{column<EmployeeField::name>()[index], column<EmployeeField::department>()[index],
+                      column<EmployeeField::salary>()[index], column<EmployeeField::hire_date>()[index]};
+    }
+
+    template <EmployeeField Field>
+    std::vector<column_type<Field>>& column() { return std::get<static_cast<std::size_t>(Field)>(columns); }
+
+    template <EmployeeField Field>
+    const std::vector<column_type<Field>>& column() const { return std::get<static_cast<std::size_t>(Field)>(columns); }
+
+    // Runs an action over the whole table. Actions declaring reads/writes get only those
+    // columns; any other action is applied row by row, which requires it to keep the row type.
+    template <typename Action, typename... Args>
+    void apply(const Args&... args) {
+        if constexpr (requires { typename Action::reads; typename Action::writes; }) {
+            Action::apply_columns(ColumnView<EmployeeTable, typename Action::reads, typename Action::writes>(*this), args...);
+        } else {
+            static_assert(std::is_same_v<decltype(Action::template apply<Record>(std::declval<Record>(), args...)), Record>,
+                          "row-wise actions on an EmployeeTable must not change the record type");
+            for (std::size_t i = 0; i < size(); ++i) {
+                Record record = Action::template apply<Record>(take_row(i), args...);
+                column<EmployeeField::name>()[i] = std::move(record.name);
+                column<EmployeeField::department>()[i] = std::move(record.department);
+                column<EmployeeField::salary>()[i] = std::move(record.salary);
+                column<EmployeeField::hire_date>()[i] = std::move(record.hire_date);
+            }
+        }
+    }
+
+private:
+    Record take_row(std::size_t index) {
+        return Record{std::move(column<EmployeeField::name>()[index]), std::move(column<EmployeeField::department>()[index]),
+                      std::move(column<EmployeeField::salary>()[index]), std::move(column<EmployeeField::hire_date>()[index])};
+    }
+
+    std::tuple<std::vector<NameType>, std::vector<DepartmentType>, std::vector<SalaryType>, std::vector<HireDateType>> columns;
+};
+
 // ---------------------- Example Actions (Processing Steps) ----------------------
 
 // A simple action to update the department
 struct DepartmentUpdater {
     template <typename Record>
     static auto apply(Record record, std::string new_department) {
-        return EmployeeRecord<typename std::remove_cvref_t<decltype(record.name)>, std::string, typename std::remove_cvref_t<decltype(record.salary)>, typename std::remove_cvref_t<decltype(record.hire_date)>>{
-            record.name, new_department, record.salary, record.hire_date
-        };
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(record.department)>, std::string>) {
+            record.department = std::move(new_department);
+            return record;
+        } else {
+            return EmployeeRecord<typename std::remove_cvref_t<decltype(record.name)>, std::string, typename std::remove_cvref_t<decltype(record.salary)>, typename std::remove_cvref_t<decltype(record.hire_date)>>{
+                std::move(record.name), std::move(new_department), record.salary, std::move(record.hire_date)
+            };
+        }
     }
 };
 
 // Another simple action to give a standard raise
 struct StandardRaise {
+    using reads = field_list<EmployeeField::salary>;
+    using writes = field_list<EmployeeField::salary>;
+
+    // Columnar form: a single pass over the salary column. The row form widens the salary to
+    // double, which a column cannot do in place, so only floating-point columns are accepted.
+    template <typename Columns>
+    static void apply_columns(Columns columns, double raise_percentage) {
+        auto salaries = columns.template column<EmployeeField::salary>();
+        static_assert(std::is_floating_point_v<typename decltype(salaries)::element_type>,
+                      "StandardRaise on an EmployeeTable needs a floating-point salary column");
+        const double factor = 1.0 + raise_percentage;
+        for (auto& salary : salaries) {
+            salary *= factor;
+        }
+    }
+
     template <typename Record>
     static auto apply(Record record, double raise_percentage) {
-        return EmployeeRecord<typename std::remove_cvref_t<decltype(record.name)>, typename std::remove_cvref_t<decltype(record.department)>, double, typename std::remove_cvref_t<decltype(record.hire_date)>>{
-            record.name, record.department, record.salary * (1.0 + raise_percentage), record.hire_date
-        };
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(record.salary)>, double>) {
+            record.salary *= 1.0 + raise_percentage;
+            return record;
+        } else {
+            return EmployeeRecord<typename std::remove_cvref_t<decltype(record.name)>, typename std::remove_cvref_t<decltype(record.department)>, double, typename std::remove_cvref_t<decltype(record.hire_date)>>{
+                std::move(record.name), std::move(record.department), record.salary * (1.0 + raise_percentage), std::move(record.hire_date)
+            };
+        }
+    }
+
+    // Batch form: with a double salary the raise is one multiply over the salary field of every record
+    template <typename Record>
+    static auto apply_batch(std::vector<Record> records, double raise_percentage) {
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(records[0].salary)>, double>) {
+            const double factor = 1.0 + raise_percentage;
+            for (auto& record : records) {
+                record.salary *= factor;
+            }
+            return records;
+        } else {
+            std::vector<decltype(apply<Record>(records[0], raise_percentage))> raised;
+            raised.reserve(records.size());
+            for (auto& record : records) {
+                raised.push_back(apply<Record>(std::move(record), raise_percentage));
+            }
+            return raised;
+        }
     }
 };
 
@@ -113,9 +785,34 @@ template <int NewDepartmentCode>
 struct DepartmentChanger {
     template <typename Record>
     static auto apply(Record record) {
-        return EmployeeRecord<typename std::remove_cvref_t<decltype(record.name)>, int, typename std::remove_cvref_t<decltype(record.salary)>, typename std::remove_cvref_t<decltype(record.hire_date)>>{
-            record.name, NewDepartmentCode, record.salary, record.hire_date
-        };
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(record.department)>, int>) {
+            record.department = NewDepartmentCode;
+            return record;
+        } else {
+            return EmployeeRecord<typename std::remove_cvref_t<decltype(record.name)>, int, typename std::remove_cvref_t<decltype(record.salary)>, typename std::remove_cvref_t<decltype(record.hire_date)>>{
+                std::move(record.name), NewDepartmentCode, record.salary, std::move(record.hire_date)
+            };
+        }
+    }
+
+    // Batch form: one tight loop writing the department code, in place once it is already an int
+    template <typename Record>
+    static auto apply_batch(std::vector<Record> records) {
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(records[0].department)>, int>) {
+            for (auto& record : records) {
+                record.department = NewDepartmentCode;
+            }
+            return records;
+        } else {
+            std::vector<decltype(apply<Record>(records[0]))> changed(records.size());
+            for (std::size_t i = 0; i < records.size(); ++i) {
+                changed[i].name = std::move(records[i].name);
+                changed[i].department = NewDepartmentCode;
+                changed[i].salary = records[i].salary;
+                changed[i].hire_date = std::move(records[i].hire_date);
+            }
+            return changed;
+        }
     }
 };
 
@@ -160,6 +857,14 @@ struct PercentageBonusCalculator {
     static double calculate_bonus(const Record& record, double percentage) {
         return record.salary * percentage;
     }
+
+    // Columnar form: bonuses for a whole salary column
+    template <typename SalaryType>
+    static void calculate_bonuses(std::span<const SalaryType> salaries, double percentage, std::span<double> bonuses) {
+        for (std::size_t i = 0; i < salaries.size(); ++i) {
+            bonuses[i] = salaries[i] * percentage;
+        }
+    }
 };
 
 struct FixedAmountBonusCalculator {
@@ -172,14 +877,19 @@ struct FixedAmountBonusCalculator {
 // An action that uses a third template parameter for configuration
 template <typename PayrollConfiguration>
 struct PayrollProcessor {
+    // Touches no columns, so running it over an EmployeeTable costs nothing
+    using reads = field_list<>;
+    using writes = field_list<>;
+
+    template <typename Columns>
+    static void apply_columns(Columns) {}
+
     template <typename Record>
     static auto apply(Record record) {
         // In the 1950s, payroll might involve manual calculations based on configuration.
         // This action could perform checks or transformations based on PayrollConfiguration.
         // For simplicity, we'll just add a note for now.
-        return EmployeeRecord<typename std::remove_cvref_t<decltype(record.name)>, typename std::remove_cvref_t<decltype(record.department)>, typename std::remove_cvref_t<decltype(record.salary)>, typename std::remove_cvref_t<decltype(record.hire_date)>>{
-            record.name, record.department, record.salary, record.hire_date // No actual modification here for simplicity
-        };
+        return record; // No actual modification here for simplicity
     }
 };
 
@@ -206,11 +916,420 @@ struct PerformanceReviewer {
     }
 };
 
+// An action that refuses records over a salary ceiling, as a payroll audit would
+template <int SalaryCeiling>
+struct SalaryCeilingCheck {
+    template <typename Record>
+    static auto apply(Record record) {
+        if (record.salary > SalaryCeiling) {
+            throw std::domain_error("salary above the ceiling of " + std::to_string(SalaryCeiling));
+        }
+        return record;
+    }
+};
+
 struct JohnDoeReviewer {};
 struct ExceedsExpectationsCriteria {};
 struct PromoteEmployeeProcessor {};
 
-int main() {
+// ---------------------- Streaming File Ingestion ----------------------
+
+// A record whose text fields point into the reader's mapped window
+using EmployeeRow = EmployeeRecord<std::string_view, std::string_view, double, std::string_view>;
+
+// Column widths for fixed-width files; fields are trimmed of surrounding spaces
+struct FixedWidthLayout {
+    std::size_t name_width;
+    std::size_t department_width;
+    std::size_t salary_width;
+    std::size_t hire_date_width;
+};
+
+// Reads name,department,salary,hire_date files (CSV or fixed width) by mapping a sliding
+// window of the file, so resident memory is one window plus one batch regardless of file
+// size. CSV fields may be double-quoted to contain commas; escaped quotes are not supported
+// since fields are views into the file.
+class EmployeeFileReader {
+public:
+    EmployeeFileReader(const std::filesystem::path& path, bool skip_header = true,
+                       std::size_t batch_size = 4096, std::size_t window_bytes = std::size_t{16} << 20)
+        : EmployeeFileReader(path, std::nullopt, skip_header, batch_size, window_bytes) {}
+
+    EmployeeFileReader(const std::filesystem::path& path, FixedWidthLayout layout,
+                       std::size_t batch_size = 4096, std::size_t window_bytes = std::size_t{16} << 20)
+        : EmployeeFileReader(path, std::optional<FixedWidthLayout>(layout), false, batch_size, window_bytes) {}
+
+    EmployeeFileReader(const EmployeeFileReader&) = delete;
+    EmployeeFileReader& operator=(const EmployeeFileReader&) = delete;
+
+    ~EmployeeFileReader() { ::close(fd); }
+
+    // Calls fn(std::span<const EmployeeRow>) per batch; the views are only valid during the call.
+    // Returns the number of rows read.
+    template <typename Fn>
+    std::size_t for_each_batch(Fn&& fn) {
+        std::vector<EmployeeRow> rows;
+        rows.reserve(batch_size);
+        std::size_t total = 0;
+        std::size_t line_number = 0;
+        std::size_t offset = 0;
+        bool header_pending = skip_header;
+
+        while (offset < file_size) {
+            const std::size_t window_start = offset - offset % page_size;
+            const std::size_t window_length = std::min(window_bytes, file_size - window_start);
+            const bool window_reaches_end = window_start + window_length == file_size;
+            Window window(fd, window_start, window_length);
+
+            const char* cursor = window.data + (offset - window_start);
+            const char* const end = window.data + window_length;
+            while (cursor < end) {
+                const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+                if (!newline && !window_reaches_end) {
+                    break; // The line continues past this window
+                }
+                const char* line_end = newline ? newline : end;
+                std::string_view line(cursor, line_end - cursor);
+                cursor = newline ? newline + 1 : end;
+                ++line_number;
+                if (!line.empty() && line.back() == '\r') {
+                    line.remove_suffix(1);
+                }
+                if (line.empty()) {
+                    continue;
+                }
+                if (header_pending) {
+                    header_pending = false;
+                    continue;
+                }
+                rows.push_back(layout ? parse_fixed_width(line, line_number) : parse_csv(line, line_number));
+                if (rows.size() == batch_size) {
+                    total += flush(rows, fn);
+                }
+            }
+
+            const std::size_t next_offset = window_start + (cursor - window.data);
+            if (next_offset == offset) {
+                throw std::runtime_error("line " + std::to_string(line_number + 1) + " is longer than the read window");
+            }
+            // The window is unmapped next, so hand over every view into it first
+            total += flush(rows, fn);
+            offset = next_offset;
+        }
+        return total;
+    }
+
+    std::size_t size_bytes() const { return file_size; }
+
+private:
+    struct Window {
+        Window(int fd, std::size_t offset, std::size_t length) : length(length) {
+            void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(offset));
+            if (mapping == MAP_FAILED) {
+                throw std::system_error(errno, std::generic_category(), "mmap");
+            }
+            ::madvise(mapping, length, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(mapping);
+        }
+        ~Window() { ::munmap(const_cast<char*>(data), length); }
+        Window(const Window&) = delete;
+        Window& operator=(const Window&) = delete;
+
+        const char* data;
+        std::size_t length;
+    };
+
+    EmployeeFileReader(const std::filesystem::path& path, std::optional<FixedWidthLayout> layout, bool skip_header,
+                       std::size_t batch_size, std::size_t window_bytes)
+        : layout(layout), skip_header(skip_header), batch_size(std::max<std::size_t>(batch_size, 1)),
+          page_size(static_cast<std::size_t>(::sysconf(_SC_PAGESIZE))) {
+        // Whole pages, and at least two so a window always covers a page past its start offset
+        this->window_bytes = std::max((window_bytes + page_size - 1) / page_size, std::size_t{2}) * page_size;
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "open " + path.string());
+        }
+        struct stat status {};
+        if (::fstat(fd, &status) != 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "fstat " + path.string());
+        }
+        file_size = static_cast<std::size_t>(status.st_size);
+    }
+
+    template <typename Fn>
+    static std::size_t flush(std::vector<EmployeeRow>& rows, Fn& fn) {
+        const std::size_t count = rows.size();
+        if (count > 0) {
+            fn(std::span<const EmployeeRow>(rows));
+            rows.clear();
+        }
+        return count;
+    }
+
+    static std::string_view trim(std::string_view field) {
+        const auto first = field.find_first_not_of(' ');
+        if (first == std::string_view::npos) {
+            return {};
+        }
+        return field.substr(first, field.find_last_not_of(' ') - first + 1);
+    }
+
+    static double parse_salary(std::string_view field, std::size_t line_number) {
+        double salary = 0;
+        const auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), salary);
+        if (error != std::errc{} || end != field.data() + field.size()) {
+            throw std::runtime_error("line " + std::to_string(line_number) + ": invalid salary '" + std::string(field) + "'");
+        }
+        return salary;
+    }
+
+    static EmployeeRow parse_csv(std::string_view line, std::size_t line_number) {
+        std::array<std::string_view, 4> fields;
+        std::size_t count = 0;
+        std::size_t position = 0;
+        while (true) {
+            std::string_view field;
+            if (position < line.size() && line[position] == '"') {
+                const auto closing = line.find('"', position + 1);
+                if (closing == std::string_view::npos) {
+                    throw std::runtime_error("line " + std::to_string(line_number) + ": unterminated quoted field");
+                }
+                field = line.substr(position + 1, closing - position - 1);
+                position = closing + 1;
+                if (position < line.size() && line[position] != ',') {
+                    throw std::runtime_error("line " + std::to_string(line_number) + ": text after closing quote");
+                }
+            } else {
+                const auto comma = std::min(line.find(',', position), line.size());
+                field = trim(line.substr(position, comma - position));
+                position = comma;
+            }
+            if (count == fields.size()) {
+                throw std::runtime_error("line " + std::to_string(line_number) + ": expected 4 fields");
+            }
+            fields[count++] = field;
+            if (position >= line.size()) {
+                break;
+            }
+            ++position; // Skip the comma
+        }
+        if (count != fields.size()) {
+            throw std::runtime_error("line " + std::to_string(line_number) + ": expected 4 fields");
+        }
+        return EmployeeRow{fields[0], fields[1], parse_salary(fields[2], line_number), fields[3]};
+    }
+
+    EmployeeRow parse_fixed_width(std::string_view line, std::size_t line_number) const {
+        const std::size_t widths[] = {layout->name_width, layout->department_width, layout->salary_width, layout->hire_date_width};
+        std::array<std::string_view, 4> fields;
+        std::size_t position = 0;
+        for (std::size_t i = 0; i < fields.size(); ++i) {
+            // The last column may be short when trailing spaces were stripped
+            if (position > line.size() || (i + 1 < fields.size() && position + widths[i] > line.size())) {
+                throw std::runtime_error("line " + std::to_string(line_number) + ": shorter than the fixed-width layout");
+            }
+            fields[i] = trim(line.substr(position, widths[i]));
+            position += widths[i];
+        }
+        return EmployeeRow{fields[0], fields[1], parse_salary(fields[2], line_number), fields[3]};
+    }
+
+    std::optional<FixedWidthLayout> layout;
+    bool skip_header;
+    std::size_t batch_size;
+    std::size_t page_size;
+    std::size_t window_bytes = 0;
+    int fd = -1;
+    std::size_t file_size = 0;
+};
+
+// Streams a file through the actions batch by batch; sink receives each batch of results
+// as a std::span and must copy out anything it keeps. Returns the number of rows read.
+template <typename... Actions, typename Sink, typename... StageArgs>
+std::size_t process_file(EmployeeFileReader& reader, Sink&& sink, const StageArgs&... stage_args) {
+    return reader.for_each_batch([&](std::span<const EmployeeRow> rows) {
+        auto results = BatchProcessingPipeline<EmployeeRow, Actions...>::run(std::vector<EmployeeRow>(rows.begin(), rows.end()), stage_args...);
+        sink(std::span<const typename decltype(results)::value_type>(results));
+    });
+}
+
+// ---------------------- Benchmarks ----------------------
+
+namespace Benchmarks {
+    template <typename Fn>
+    double time_ms(Fn&& fn) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void report(const std::string& name, double baseline, double candidate, const std::string& unit = "ms") {
+        std::cout << name << ": " << baseline << " " << unit << " -> " << candidate << " " << unit << " (x"
+                  << (candidate > 0 ? baseline / candidate : 0.0) << ")\n";
+    }
+
+    void bench_fused_run() {
+        using Record = EmployeeRecord<const char*, const char*, double, const char*>;
+        using Pipeline = DataProcessingPipeline<Record, StandardRaise, PayrollProcessor<StandardPayroll>, DepartmentChanger<7>>;
+        std::vector<Record> records;
+        for (int i = 0; i < 2'000'000; ++i) {
+            records.push_back(Record{"Clerk", "Clerical", 3000.0 + i % 1000, "1957-06-01"});
+        }
+        std::vector<EmployeeRecord<const char*, int, double, const char*>> out(records.size());
+
+        double sink = 0;
+        std::cout << "Fused run over " << records.size() << " records\n";
+        const double hand_written = time_ms([&] {
+            for (std::size_t i = 0; i < records.size(); ++i) {
+                out[i] = {records[i].name, 7, records[i].salary * (1.0 + 0.05), records[i].hire_date};
+            }
+            sink += out.back().salary;
+        });
+        const double staged = time_ms([&] {
+            for (std::size_t i = 0; i < records.size(); ++i) {
+                out[i] = Pipeline(records[i]).process(0.05).process().process().get_final_record();
+            }
+            sink += out.back().salary;
+        });
+        const double fused = time_ms([&] {
+            for (std::size_t i = 0; i < records.size(); ++i) {
+                out[i] = Pipeline::run(records[i], 0.05, std::tuple{}, std::tuple{});
+            }
+            sink += out.back().salary;
+        });
+        report("hand-written vs fused run", hand_written, fused);
+        report("process() chain vs fused run", staged, fused);
+        std::cout << "(checksum " << sink << ")\n";
+    }
+
+    void bench_columnar_raise() {
+        using Record = EmployeeRecord<const char*, const char*, double, const char*>;
+        std::vector<Record> records;
+        for (int i = 0; i < 1'000'000; ++i) {
+            records.push_back(Record{"Clerk", "Clerical", 3000.0 + i % 1000, "1957-06-01"});
+        }
+        EmployeeTable<const char*, const char*, double, const char*> table{std::span<const Record>(records)};
+
+        std::cout << "Columnar raise over " << records.size() << " employees, 10 rounds\n";
+        const double rows = time_ms([&] {
+            for (int round = 0; round < 10; ++round) {
+                records = apply_to_batch<StandardRaise>(std::move(records), 0.01);
+            }
+        });
+        const double table_columns = time_ms([&] {
+            for (int round = 0; round < 10; ++round) {
+                table.apply<StandardRaise>(0.01);
+            }
+        });
+        report("row batch vs EmployeeTable", rows, table_columns);
+        std::cout << "(checksum " << records.back().salary + table.column<EmployeeField::salary>().back() << ")\n";
+    }
+
+    void bench_pipelined_executor() {
+        using Record = EmployeeRecord<std::string, const char*, double, const char*>;
+        std::vector<Record> records;
+        for (int i = 0; i < 200'000; ++i) {
+            records.push_back(Record{"Clerk number " + std::to_string(i) + " of the tabulating pool", "Clerical", 3000.0 + i % 1000, "1957-06-01"});
+        }
+        const std::string department = "Electronic Data Processing Division";
+
+        double sink = 0;
+        std::cout << "Pipelined executor over " << records.size() << " records, "
+                  << std::thread::hardware_concurrency() << " hardware threads\n";
+        const double serial = time_ms([&] {
+            for (const auto& record : records) {
+                sink += DataProcessingPipeline<Record, DepartmentUpdater, StandardRaise, PayrollProcessor<StandardPayroll>>::run(
+                            record, department, 0.05, std::tuple{}).salary;
+            }
+        });
+        auto executor = start_pipelined_processing<Record, DepartmentUpdater, StandardRaise, PayrollProcessor<StandardPayroll>>(
+            1024, department, 0.05, std::tuple{});
+        const double pipelined = time_ms([&] {
+            for (const auto& record : executor.run(std::span<const Record>(records))) {
+                sink += record.salary;
+            }
+        });
+        report("serial run vs pipelined", serial, pipelined);
+        for (std::size_t stage = 0; stage < executor.stages(); ++stage) {
+            const auto stats = executor.stage_stats(stage);
+            std::cout << "  stage " << stage << ": " << stats.processed << " records, " << stats.records_per_second
+                      << " records/s, peak queue " << stats.peak_queue_depth << ", stalls " << stats.output_stalls << "\n";
+        }
+        std::cout << "(checksum " << sink << ")\n";
+    }
+
+    void bench_file_ingestion() {
+        const auto path = std::filesystem::temp_directory_path() / ("n315_bench_employees_" + std::to_string(::getpid()) + ".csv");
+        const int line_count = 1'000'000;
+        {
+            std::ofstream out(path);
+            out << "name,department,salary,hire_date\n";
+            for (int i = 0; i < line_count; ++i) {
+                out << "Employee " << i << ",Department " << i % 17 << "," << 2000 + i % 5000 << ".25,1958-04-" << 10 + i % 19 << "\n";
+            }
+        }
+
+        double sink = 0;
+        std::cout << "File ingestion of " << line_count << " CSV lines (" << std::filesystem::file_size(path) / (1 << 20) << " MiB)\n";
+        const double parsed = time_ms([&] {
+            // Parse everything into owning records first, then run the pipeline
+            std::ifstream in(path);
+            std::string line;
+            std::getline(in, line);
+            std::vector<EmployeeRecord<std::string, std::string, double, std::string>> records;
+            while (std::getline(in, line)) {
+                const auto first = line.find(','), second = line.find(',', first + 1), third = line.find(',', second + 1);
+                records.push_back({line.substr(0, first), line.substr(first + 1, second - first - 1),
+                                   std::stod(line.substr(second + 1, third - second - 1)), line.substr(third + 1)});
+            }
+            for (auto& record : records) {
+                sink += DataProcessingPipeline<EmployeeRecord<std::string, std::string, double, std::string>, StandardRaise, DepartmentChanger<3>>::run(
+                            std::move(record), 0.05, std::tuple{}).salary;
+            }
+        });
+        const double streamed = time_ms([&] {
+            EmployeeFileReader reader(path);
+            process_file<StandardRaise, DepartmentChanger<3>>(reader, [&](auto results) {
+                for (const auto& record : results) {
+                    sink += record.salary;
+                }
+            }, 0.05, std::tuple{});
+        });
+        report("getline+stod vs mmap stream", parsed, streamed);
+        std::cout << "(checksum " << sink << ")\n";
+        std::filesystem::remove(path);
+    }
+
+    void run_all_benchmarks() {
+        bench_fused_run();
+        bench_columnar_raise();
+        bench_pipelined_executor();
+        bench_file_ingestion();
+    }
+} // namespace Benchmarks
+
+// Heap allocation counter backing the allocation-free pipeline test
+static std::atomic<std::size_t> heap_allocations{0};
+
+void* operator new(std::size_t size) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string_view(argv[1]) == "--bench") {
+        Benchmarks::run_all_benchmarks();
+        return 0;
+    }
+
     // --- Test Cases ---
 
     // Test 1: Simple department update
@@ -289,5 +1408,243 @@ int main() {
         // The actual outcome depends on your PerformanceReviewer implementation
     }
 
+    // Test 8: Batch mode matches the per-record pipeline, with and without apply_batch
+    {
+        using Record = EmployeeRecord<const char*, const char*, double, const char*>;
+        std::vector<Record> records;
+        for (int i = 0; i < 1000; ++i) {
+            records.push_back(Record{"Clerk", "Clerical", 3000.0 + i, "1957-06-01"});
+        }
+        auto batch = start_batch_processing<Record, DepartmentUpdater, StandardRaise, PayrollProcessor<StandardPayroll>, DepartmentChanger<7>>(
+            std::span<const Record>(records));
+        auto final_records = batch.process(std::string{"Typing Pool"}).process(0.05).process().process().get_final_records();
+        static_assert(std::is_same_v<decltype(final_records), std::vector<EmployeeRecord<const char*, int, double, const char*>>>,
+                      "Test 8 Failed: Incorrect batch record type");
+        assert(final_records.size() == records.size());
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            auto single = start_processing<Record, DepartmentUpdater, StandardRaise, PayrollProcessor<StandardPayroll>, DepartmentChanger<7>>(records[i])
+                              .process(std::string{"Typing Pool"}).process(0.05).process().process().get_final_record();
+            assert(final_records[i].salary == single.salary);
+            assert(final_records[i].department == 7);
+        }
+        std::cout << "Test 8: Batch Processing of " << final_records.size() << " records, last salary: " << final_records.back().salary << std::endl;
+    }
+
+    // Test 9: A multi-stage run moves heap-owning fields through every stage without allocating
+    {
+        using Record = EmployeeRecord<std::string, const char*, double, std::string>;
+        Record record{"Margaret Hamilton-Whitfield of the Tabulating Department", "Clerical", 4200.0,
+                      "Hired on the first Monday of June, nineteen fifty-seven"};
+        std::string department = "Research and Development, Electronic Computing Division";
+        const char* name_buffer = record.name.data();
+
+        const std::size_t allocations_before = heap_allocations.load();
+        auto updated_record = start_processing<Record, DepartmentUpdater, StandardRaise, PayrollProcessor<StandardPayroll>,
+                                               DepartmentUpdater, BonusAllocator<SalesBonusCriteria, PercentageBonusCalculator>>(std::move(record))
+                                  .process(std::move(department))
+                                  .process(0.10)
+                                  .process()
+                                  .process(std::string{"Typing Pool"})
+                                  .process()
+                                  .get_final_record();
+        const std::size_t allocations = heap_allocations.load() - allocations_before;
+
+        static_assert(std::is_same_v<decltype(updated_record), EmployeeRecord<std::string, std::string, double, std::string>>,
+                      "Test 9 Failed: Incorrect record type");
+        assert(allocations == 0);
+        assert(updated_record.name.data() == name_buffer);
+        assert(updated_record.department == "Typing Pool");
+        assert(updated_record.salary == 4200.0 * 1.10);
+        std::cout << "Test 9: Move-only pipeline, heap allocations: " << allocations << ", Record: " << updated_record << std::endl;
+    }
+
+    // Test 10: Fused run matches the staged pipeline, with stage arguments bound by position
+    {
+        using Record = EmployeeRecord<const char*, const char*, double, const char*>;
+        using Pipeline = DataProcessingPipeline<Record, DepartmentUpdater, StandardRaise, PayrollProcessor<ExecutivePayroll>, DepartmentChanger<42>>;
+        Record record{"Kenneth Lane", "Mailroom", 3600.0, "1958-08-11"};
+        auto fused_record = Pipeline::run(record, std::string{"Shipping"}, std::tuple{0.25}, std::tuple{}, std::tuple{});
+        auto staged_record = Pipeline(record).process(std::string{"Shipping"}).process(0.25).process().process().get_final_record();
+        static_assert(std::is_same_v<decltype(fused_record), decltype(staged_record)>, "Test 10 Failed: Incorrect record type");
+        assert(fused_record.department == 42);
+        assert(fused_record.salary == staged_record.salary);
+        assert(fused_record.salary == 4500.0);
+        std::cout << "Test 10: Fused Run, Record: " << fused_record << std::endl;
+    }
+
+    // Test 11: EmployeeTable runs declared-column actions over columns and others row by row
+    {
+        using Record = EmployeeRecord<const char*, std::string, double, const char*>;
+        std::vector<Record> records;
+        for (int i = 0; i < 100; ++i) {
+            records.push_back(Record{"Typist", "Clerical", 2000.0 + 10 * i, "1959-02-02"});
+        }
+        EmployeeTable<const char*, std::string, double, const char*> table{std::span<const Record>(records)};
+        table.apply<StandardRaise>(0.10);
+        table.apply<PayrollProcessor<StandardPayroll>>();
+        table.apply<DepartmentUpdater>(std::string{"Secretarial"});
+
+        std::vector<double> bonuses(table.size());
+        PercentageBonusCalculator::calculate_bonuses(std::span<const double>(table.column<EmployeeField::salary>()), 0.05, std::span<double>(bonuses));
+
+        assert(table.size() == records.size());
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            auto expected = start_processing<Record, StandardRaise, PayrollProcessor<StandardPayroll>, DepartmentUpdater>(records[i])
+                                .process(0.10).process().process(std::string{"Secretarial"}).get_final_record();
+            auto row = table.row(i);
+            assert(row.salary == expected.salary);
+            assert(row.department == expected.department);
+            assert(bonuses[i] == PercentageBonusCalculator::calculate_bonus(expected, 0.05));
+        }
+        std::cout << "Test 11: Employee Table, last row: " << table.row(table.size() - 1) << ", bonus: " << bonuses.back() << std::endl;
+    }
+
+    // Test 12: Pipelined executor matches the serial process() chain, under backpressure
+    {
+        using Record = EmployeeRecord<std::string, const char*, double, const char*>;
+        std::vector<Record> records;
+        for (int i = 0; i < 5000; ++i) {
+            records.push_back(Record{"Operator " + std::to_string(i), "Keypunch", 2500.0 + i, "1960-03-14"});
+        }
+        auto executor = start_pipelined_processing<Record, DepartmentUpdater, StandardRaise, PayrollProcessor<StandardPayroll>, DepartmentChanger<12>>(
+            4, std::string{"Data Processing"}, 0.03, std::tuple{}, std::tuple{});
+        auto results = executor.run(std::span<const Record>(records));
+
+        assert(results.size() == records.size());
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            auto expected = start_processing<Record, DepartmentUpdater, StandardRaise, PayrollProcessor<StandardPayroll>, DepartmentChanger<12>>(records[i])
+                                .process(std::string{"Data Processing"}).process(0.03).process().process().get_final_record();
+            static_assert(std::is_same_v<decltype(expected), std::remove_cvref_t<decltype(results[i])>>, "Test 12 Failed: Incorrect record type");
+            assert(results[i].name == expected.name);
+            assert(results[i].department == expected.department);
+            assert(results[i].salary == expected.salary);
+        }
+        for (std::size_t stage = 0; stage < executor.stages(); ++stage) {
+            const auto stats = executor.stage_stats(stage);
+            assert(stats.processed == records.size());
+            assert(stats.queue_depth == 0);
+            assert(stats.peak_queue_depth <= 4);
+        }
+
+        bool rerun_refused = false;
+        try {
+            executor.run(std::span<const Record>(records));
+        } catch (const std::logic_error&) {
+            rerun_refused = true;
+        }
+        assert(rerun_refused);
+
+        // Streaming use: a producer thread pushes while this thread pops and a monitor polls stats
+        auto streaming = start_pipelined_processing<Record, StandardRaise, DepartmentUpdater>(2, 0.5, std::string{"Archive"});
+        std::atomic<bool> streaming_done{false};
+        std::size_t impossible_depths = 0;
+        std::thread monitor([&] {
+            while (!streaming_done.load()) {
+                for (std::size_t stage = 0; stage < streaming.stages(); ++stage) {
+                    impossible_depths += streaming.stage_stats(stage).queue_depth > 2 ? 1 : 0;
+                }
+            }
+        });
+        std::thread producer([&] {
+            for (const auto& record : records) {
+                streaming.push(record);
+            }
+            streaming.close();
+        });
+        std::size_t streamed = 0;
+        while (auto record = streaming.pop()) {
+            assert(record->salary == records[streamed].salary * 1.5);
+            ++streamed;
+        }
+        producer.join();
+        streaming_done.store(true);
+        monitor.join();
+        assert(streamed == records.size());
+        assert(impossible_depths == 0);
+
+        // An idle executor parks its workers instead of spinning
+        {
+            auto idle = start_pipelined_processing<Record, StandardRaise, DepartmentUpdater>(16, 0.5, std::string{"Archive"});
+            const std::clock_t cpu_before = std::clock();
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            const double cpu_ms = 1000.0 * static_cast<double>(std::clock() - cpu_before) / CLOCKS_PER_SEC;
+            assert(cpu_ms < 100.0);
+        }
+
+        // An action that throws stops the pipeline and the error reaches the caller
+        auto audited = start_pipelined_processing<Record, StandardRaise, SalaryCeilingCheck<5000>, PayrollProcessor<StandardPayroll>>(
+            4, 0.03, std::tuple{}, std::tuple{});
+        bool audit_failed = false;
+        try {
+            audited.run(std::span<const Record>(records));
+        } catch (const std::domain_error&) {
+            audit_failed = true;
+        }
+        assert(audit_failed);
+        std::cout << "Test 12: Pipelined Executor, " << results.size() << " records, last: " << results.back() << std::endl;
+    }
+
+    // Test 13: Streaming CSV and fixed-width ingestion across sliding windows and batches
+    {
+        const auto csv_path = std::filesystem::temp_directory_path() / ("n315_test_employees_" + std::to_string(::getpid()) + ".csv");
+        const auto fixed_path = std::filesystem::temp_directory_path() / ("n315_test_employees_" + std::to_string(::getpid()) + ".txt");
+        const int line_count = 3000;
+        double expected_total = 0;
+        {
+            std::ofstream csv(csv_path, std::ios::binary);
+            std::ofstream fixed(fixed_path, std::ios::binary);
+            csv << "name,department,salary,hire_date\r\n";
+            for (int i = 0; i < line_count; ++i) {
+                const double salary = 1000.5 + i;
+                expected_total += salary * 1.10;
+                csv << "\"Doe, Jane " << i << "\",Records," << salary << ",1961-01-0" << i % 9 + 1 << (i % 2 ? "\r\n" : "\n");
+                std::string name = "Clerk " + std::to_string(i);
+                std::string salary_text = std::to_string(salary);
+                fixed << name << std::string(20 - name.size(), ' ') << "Filing    " << std::string(12 - salary_text.size(), ' ') << salary_text << "1961-01-02\n";
+            }
+            csv << "\"Last, Line\",Records,10,1961-12-31"; // No trailing newline
+            expected_total += 10 * 1.10;
+        }
+
+        std::size_t batches = 0;
+        double total = 0;
+        EmployeeFileReader csv_reader(csv_path, true, 64, 4096);
+        const std::size_t csv_rows = process_file<StandardRaise, PayrollProcessor<StandardPayroll>, DepartmentChanger<8>>(
+            csv_reader,
+            [&](auto results) {
+                static_assert(std::is_same_v<typename decltype(results)::element_type, const EmployeeRecord<std::string_view, int, double, std::string_view>>,
+                              "Test 13 Failed: Incorrect record type");
+                assert(results.size() <= 64);
+                for (const auto& record : results) {
+                    assert(record.name.starts_with("Doe, Jane ") || record.name == "Last, Line");
+                    assert(record.department == 8);
+                    total += record.salary;
+                }
+                ++batches;
+            },
+            0.10, std::tuple{}, std::tuple{});
+        assert(csv_rows == line_count + 1);
+        assert(batches > csv_rows / 64);
+        assert(std::abs(total - expected_total) < 1e-6 * expected_total);
+
+        std::size_t fixed_rows = 0;
+        EmployeeFileReader fixed_reader(fixed_path, FixedWidthLayout{20, 10, 12, 10}, 100, 8192);
+        fixed_reader.for_each_batch([&](std::span<const EmployeeRow> rows) {
+            for (const auto& row : rows) {
+                assert(row.name == "Clerk " + std::to_string(fixed_rows));
+                assert(row.department == "Filing");
+                assert(row.salary == 1000.5 + static_cast<double>(fixed_rows));
+                assert(row.hire_date == "1961-01-02");
+                ++fixed_rows;
+            }
+        });
+        assert(fixed_rows == line_count);
+
+        std::filesystem::remove(csv_path);
+        std::filesystem::remove(fixed_path);
+        std::cout << "Test 13: Streaming Ingestion, " << csv_rows << " CSV rows in " << batches << " batches, "
+                  << fixed_rows << " fixed-width rows" << std::endl;
+    }
+
     return 0;
 }
\ No newline at end of file